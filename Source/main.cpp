@@ -5,7 +5,7 @@
  * @brief This app was made to automate Unit Testing in MQL5.
  * @details It contains 3 tools that make the wholw process totally automatic.
  * Each tool is better explained in the Readme and in their respective
- * classes.
+ * classes. The "run" argument chains all of them in a single pipeline.
  */
 
 #include <QCoreApplication>
@@ -15,6 +15,7 @@
 #include "mtUnitEALinker.h"
 #include "mtUnitLogger.h"
 #include "mtUnitTestsCompiler.h"
+#include "mtUnitRunner.h"
 
 //#define DEBUGGING
 
@@ -43,32 +44,44 @@ int main(int argc, char *argv[])
     for(int i = 1; i < argc; i++)
         argvv.append(argv[i]);
 #endif
-    if(argvv.size() == 1 && argvv[0] == "mtUnitTestsCompiler")
+    if(!argvv.isEmpty() && argvv[0] == "mtUnitTestsCompiler")
     {
         MTUnitTestsCompiler *testsCompiler = new MTUnitTestsCompiler();
+        for(int i = 1; i < argvv.size(); i++)
+        {
+            if(argvv[i] == "compact")
+                testsCompiler->setRunnerMode(MTUnitTestsCompiler::CompactRunner);
+            else if(argvv[i] == "resume")
+                testsCompiler->setResumeMode(MTUnitTestsCompiler::ResumeAfterLastCase);
+            else if(argvv[i] == "resumeSkip")
+                testsCompiler->setResumeMode(MTUnitTestsCompiler::ResumeSkippingCrashedCase);
+            else
+            {
+                qDebug() << "Error: Unknown option " << argvv[i];
+                return -1;
+            }
+        }
         return testsCompiler->start(upDir.path());
     }
     if(argvv.size() == 2 && argvv[0] == "mtUnitEALinker")
     {
-        if(argvv[1].contains(".mqh"))
-        {
-            qDebug() << "Error: Cannot run Header Files (.mqh)";
+        QString expertName = MTUnitEALinker::expertName(argvv[1]);
+        if(expertName.isEmpty())
             return -1;
-        }
-        if(argvv[1].contains("MQL5\\Experts\\")) //Not sure if it will come as back or forward slashes
-            argvv[1].remove(0, argvv[1].indexOf("MQL5\\Experts\\") + 13);
-        else if(argvv[1].contains("MQL5/Experts/")) //Just in case, we do it for both cases
-            argvv[1].remove(0, argvv[1].indexOf("MQL5/Experts/") + 13);
-        argvv[1].replace(".mq", ".ex");
 
         MTUnitEALinker *eaLinker = new MTUnitEALinker();
-        return eaLinker->start(upDir.path(), argvv[1]);
+        return eaLinker->start(upDir.path(), expertName);
     }
     if(argvv.size() == 1 && argvv[0] == "mtUnitLogger")
     {
         MTUnitLogger *logger = new MTUnitLogger();
         return logger->start(upDir.path());
     }
+    if((argvv.size() == 1 || argvv.size() == 2) && argvv[0] == "run")
+    {
+        MTUnitRunner *runner = new MTUnitRunner();
+        return runner->start(upDir.path(), argvv.value(1));
+    }
     if(argvv.isEmpty()) //Init Watcher
     {
         MTUnitTestsCompiler *testsCompiler = new MTUnitTestsCompiler();
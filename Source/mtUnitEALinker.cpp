@@ -13,7 +13,8 @@
 #include "mtUnitEALinker.h"
 
 /**
- * @brief Open the config file and edit the EA parameter
+ * @brief Open the config file and edit the EA parameter. If requested, it
+ * also makes the terminal shut down once the test is done.
  * @param rootDir
  * @param eaPath
  * @return The result of the procedure. (-1 = failure, 1 = success)
@@ -26,27 +27,28 @@ int MTUnitEALinker::start(QString rootDir, QString eaPath)
         qDebug() << "Generating config file to run " << eaPath;
         QTextStream in(&inputFile);
         QStringList content = in.readAll().split('\n');
+        bool shutdownFound = false;
         for(int i = 0; i < content.size(); i++)
         {
             QString line = content[i];
             if(line.startsWith("Expert="))
                 content[i] = "Expert=" + QString(eaPath);
-        }
-        inputFile.close();
-
-        QFile outputFile(rootDir + "/Runners/autoRunTest.ini"); //Overwrites it
-        if(outputFile.open(QIODevice::WriteOnly | QIODevice::Text))
-        {
-            QTextStream out(&outputFile);
-            for(int i = 0; i < content.size(); i++)
+            if(m_shutdownTerminal && line.remove(';').trimmed().startsWith("ShutdownTerminal=")) //Even if commented out
             {
-                out << content[i];
-                if(i < content.size()-1)
-                    out << endl;
+                content[i] = "ShutdownTerminal=1";
+                shutdownFound = true;
             }
-            outputFile.close();
         }
-        else
+        if(m_shutdownTerminal && !shutdownFound)
+        {
+            int testerSection = content.indexOf("[Tester]");
+            content.insert(testerSection + 1, "ShutdownTerminal=1"); //Right after [Tester] (or at the top if it is missing)
+        }
+        inputFile.close();
+
+        MTUnitOutput out(int(inputFile.size()) + eaPath.size() + 64);
+        out << content.join("\n");
+        if(out.saveAs(rootDir + "/Runners/autoRunTest.ini") < 0) //Overwrites it
         {
             qDebug() << "Error writing autoRunTest.ini";
             return -1;
@@ -60,3 +62,24 @@ int MTUnitEALinker::start(QString rootDir, QString eaPath)
     qDebug() << "autoRunTest.ini configured successfully!";
     return 1;
 }
+
+/**
+ * @brief Converts the path of the EA source (.mq5) into the name the
+ * config file expects: relative to MQL5/Experts and pointing to the .ex5
+ * @param eaPath
+ * @return The Expert name, or an empty string if eaPath is a Header File
+ */
+QString MTUnitEALinker::expertName(QString eaPath)
+{
+    if(eaPath.contains(".mqh"))
+    {
+        qDebug() << "Error: Cannot run Header Files (.mqh)";
+        return QString();
+    }
+    if(eaPath.contains("MQL5\\Experts\\")) //Not sure if it will come as back or forward slashes
+        eaPath.remove(0, eaPath.indexOf("MQL5\\Experts\\") + 13);
+    else if(eaPath.contains("MQL5/Experts/")) //Just in case, we do it for both cases
+        eaPath.remove(0, eaPath.indexOf("MQL5/Experts/") + 13);
+    eaPath.replace(".mq", ".ex");
+    return eaPath;
+}
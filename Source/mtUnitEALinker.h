@@ -19,13 +19,21 @@
 #include <QTextStream>
 #include <QDebug>
 
+#include "mtUnitOutput.h"
+
 class MTUnitEALinker
 {
 public:
-    MTUnitEALinker(){}
+    MTUnitEALinker() : m_shutdownTerminal(false) {}
     ~MTUnitEALinker(){}
 
     int start(QString rootDir, QString eaPath);
+    void setShutdownTerminal(bool shutdown) { m_shutdownTerminal = shutdown; }
+
+    static QString expertName(QString eaPath);
+
+private:
+    bool m_shutdownTerminal;
 };
 
 #endif // MTUNITEALINKER_H
@@ -18,9 +18,13 @@ TEMPLATE = app
 SOURCES += main.cpp \
     mtUnitLogger.cpp \
     mtUnitTestsCompiler.cpp \
-    mtUnitEALinker.cpp
+    mtUnitEALinker.cpp \
+    mtUnitRunner.cpp \
+    mtUnitOutput.cpp
 
 HEADERS += \
     mtUnitTestsCompiler.h \
     mtUnitEALinker.h \
-    mtUnitlogger.h
+    mtUnitlogger.h \
+    mtUnitRunner.h \
+    mtUnitOutput.h
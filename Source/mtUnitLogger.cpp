@@ -11,6 +11,9 @@
  * @warning The colored output does not work directly from MetaEditor, so if
  * you want to use it, I suggest you to follow the instructions for using this
  * tool in Sublime Text 3.
+ * @note Every run, and every Test Case that starts or ends, is also recorded
+ * in Runners/checkpoint.txt, so mtUnitTestsCompiler can resume the run if the
+ * tester dies halfway.
  */
 
 #include "mtUnitLogger.h"
@@ -18,67 +21,191 @@
 /**
  * @brief Search for the log file, hijacks it and add colors
  * @param rootDir
- * @return The result of the procedure. (0 = failure, 1 = success)
+ * @return The result of the procedure. (-1 = failure, 1 = success)
  */
 int MTUnitLogger::start(QString rootDir)
+{
+    if(beginStream(rootDir) < 0)
+        return -1;
+    return endStream();
+}
+
+/**
+ * @brief Prepares the logFile.log output and starts following the log file.
+ * The log file itself does not need to exist yet, so this can be called
+ * before the tester starts writing it.
+ * @param rootDir
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitLogger::beginStream(QString rootDir)
 {
     QFile inputFile(rootDir + "/Runners/logFolderPath.ini");
-    if(inputFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    if(!inputFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qDebug() << "logFolderPath.ini not found";
+        return -1;
+    }
+    qDebug() << "Catching output...";
+    QTextStream in(&inputFile);
+    QString logFolderPath = in.readAll().trimmed();
+    inputFile.close();
+    QFileInfo folder(logFolderPath);
+    if(!folder.exists())
     {
-        qDebug() << "Catching output...";
-        QTextStream in(&inputFile);
-        QString logFilePath = in.readAll().trimmed();
-        QFileInfo file(logFilePath);
-        if(!file.exists())
-        {
-            qDebug() << "File: " << logFilePath << " does not exist!";
-            return -1;
-        }
-        inputFile.close();
+        qDebug() << "File: " << logFolderPath << " does not exist!";
+        return -1;
+    }
+
+    QString logFileName = QDateTime::currentDateTime().toString("yyyyMMdd") + ".log"; //Name the file with today's date
+    m_logFilePath = logFolderPath + "\\" + logFileName;
+    m_logFile.setFileName(m_logFilePath);
+    m_pendingLine.clear();
+    m_runRecorded = false;
+    m_testCaseRunning = false;
+    delete m_decoder;
+    m_decoder = 0;
 
-        QString logFileName = QDateTime::currentDateTime().toString("yyyyMMdd") + ".log"; //Name the file with today's date
-        QFile logFile(logFilePath + "\\" + logFileName);
-        if(logFile.open(QIODevice::ReadOnly | QIODevice::Text))
-        {
-            QFile newLogFile(rootDir + "/Runners/logFile.log");
-            if(!newLogFile.open(QIODevice::WriteOnly | QIODevice::Text))
-            {
-                qDebug() << "Error: Could not write the logFile in: " << QString(rootDir + "/Runners/logFile.log");
-                return -1;
-            }
-            QTextStream inLog(&logFile);
-            QTextStream outLog(&newLogFile);
-            while(!inLog.atEnd())
-            {
-                QString line = inLog.readLine();
-                line.remove(0, 5); //Removes the first 5 useless characteres from the log...
-                if(line.contains("OK")) //Add green color if the test pass
-                {
-                    line.prepend("\e[32m");
-                    line.append("\e[0m");
-                }
-                if(line.contains("***FAIL***")) //Add red if it fails
-                {
-                    line.prepend("\e[31m");
-                    line.append("\e[0m");
-                }
-                outLog << line << endl;
-            }
-            logFile.close();
-            newLogFile.close();
-            QFile::remove(logFilePath + "\\" + logFileName); //Remove the original log so the new one will be fresh
-        }
-        else
-        {
-            qDebug() << "Error: Log file not found: " << logFilePath + logFileName;
-            return -1;
-        }
+    if(m_outLog.openStream(rootDir + "/Runners/logFile.log", false) < 0)
+    {
+        qDebug() << "Error: Could not write the logFile in: " << QString(rootDir + "/Runners/logFile.log");
+        return -1;
     }
-    else
+    if(m_outCheckpoint.openStream(rootDir + "/Runners/checkpoint.txt", true) < 0) //Appends, so resumed runs add to it
     {
-        qDebug() << "logFolderPath.ini not found";
+        qDebug() << "Error: Could not write the checkpoint in: " << QString(rootDir + "/Runners/checkpoint.txt");
+        m_outLog.closeStream();
+        return -1;
+    }
+    return 1;
+}
+
+/**
+ * @brief Reads whatever was appended to the log file since the last call
+ * and writes every complete line to logFile.log
+ * @return The number of lines written (-1 = failure)
+ */
+int MTUnitLogger::readAvailable()
+{
+    if(!m_outLog.isStreamOpen())
+        return -1;
+    if(!m_logFile.isOpen() && !m_logFile.open(QIODevice::ReadOnly))
+        return 0; //Not created yet, maybe on the next call
+
+    int linesWritten = 0;
+    while(true) //Bounded blocks, so a big log is never held in memory at once
+    {
+        QByteArray chunk = m_logFile.read(256 * 1024);
+        if(chunk.isEmpty())
+            break;
+        if(!m_decoder) //Same detection QTextStream does: BOM or fallback to the locale
+            m_decoder = QTextCodec::codecForUtfText(chunk, QTextCodec::codecForLocale())->makeDecoder();
+        m_pendingLine += m_decoder->toUnicode(chunk);
+
+        QStringList lines = m_pendingLine.split('\n');
+        m_pendingLine = lines.takeLast(); //Incomplete line, the rest will come in the next block
+        foreach(QString line, lines)
+            writeLine(line);
+        linesWritten += lines.size();
+    }
+    //Once per read (not per line), so the output follows the tester and the checkpoint survives a crash
+    if(m_outLog.flush() < 0 || m_outCheckpoint.flush() < 0)
+        return -1;
+    return linesWritten;
+}
+
+/**
+ * @brief Writes the remaining lines, closes logFile.log and removes the
+ * original log so the next one will be fresh
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitLogger::endStream()
+{
+    if(readAvailable() < 0)
+        return -1;
+    if(!m_logFile.isOpen())
+    {
+        qDebug() << "Error: Log file not found: " << m_logFilePath;
+        m_outLog.closeStream();
+        m_outCheckpoint.closeStream();
         return -1;
     }
+    if(!m_pendingLine.isEmpty())
+        writeLine(m_pendingLine);
+    m_pendingLine.clear();
+    m_logFile.close();
+    if(m_outLog.closeStream() < 0 || m_outCheckpoint.closeStream() < 0)
+        return -1;
+    QFile::remove(m_logFilePath); //Remove the original log so the new one will be fresh
     qDebug() << "logFile.log generated successfully!";
     return 1;
 }
+
+/**
+ * @brief Adds colors to a log line and writes it to logFile.log
+ * @param line
+ */
+void MTUnitLogger::writeLine(QString line)
+{
+    if(line.endsWith('\r'))
+        line.chop(1);
+    line.remove(0, 5); //Removes the first 5 useless characteres from the log...
+    if(!m_runRecorded) //The tester ran, even if no Test Case gets to start
+    {
+        m_outCheckpoint << "run\n";
+        m_runRecorded = true;
+    }
+    bool endedTestCase = false;
+    QString testCase = checkpointChecker(line, endedTestCase);
+    if(endedTestCase)
+    {
+        m_outCheckpoint << testCase << " - ended\n";
+        m_testCaseRunning = false;
+    }
+    else if(!m_testCaseRunning && testCaseStartChecker(line))
+    {
+        m_outCheckpoint << "started\n"; //Once per Test Case, its name comes with the end
+        m_testCaseRunning = true;
+    }
+    if(line.contains("OK")) //Add green color if the test pass
+    {
+        line.prepend("\e[32m");
+        line.append("\e[0m");
+    }
+    if(line.contains("***FAIL***")) //Add red if it fails
+    {
+        line.prepend("\e[31m");
+        line.append("\e[0m");
+    }
+    m_outLog << line << "\n";
+}
+
+/**
+ * @brief Checks whether the line reports the end of a Test Case
+ * @param line
+ * @param found
+ * @return The Test Case that ended, as "TestSuite::TestCase"
+ */
+QString MTUnitLogger::checkpointChecker(QString line, bool &found)
+{
+    found = false;
+    int endPos = line.indexOf(" - endTestCase");
+    if(endPos < 0)
+        return "";
+    QString testCase = line.left(endPos).trimmed();
+    testCase = testCase.mid(testCase.lastIndexOf(QRegExp("\\s")) + 1); //Last word before " - endTestCase"
+    if(testCase.contains("::"))
+        found = true;
+    return testCase;
+}
+
+/**
+ * @brief Checks whether the line reports the start of a Test Case
+ * @note The name printed with "Running new unit test" is still the one of
+ * the previous Test Case, so only the start itself is used.
+ * @param line
+ * @return true if a Test Case is starting
+ */
+bool MTUnitLogger::testCaseStartChecker(QString line)
+{
+    return line.contains("initTestCase") || line.contains(" - Running new unit test");
+}
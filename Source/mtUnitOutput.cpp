@@ -0,0 +1,193 @@
+/**
+ * @file mtUnitOutput.cpp
+ * @author Rodrigo Haller
+ * @date 18/10/2026
+ * @brief Buffered writer shared by all tools.
+ * @details Text is rendered into a pre-sized byte buffer that is reused
+ * between writes, so nothing is flushed line by line. Line endings are
+ * converted while rendering (\r\n on Windows) and files are opened in binary
+ * mode, so every write reaches the OS as one call. Whole files
+ * (MTUnitAllTests.mqh, autoRunTest.ini) are written with a single write
+ * and atomically replace the old file. Streams (logFile.log, checkpoint.txt)
+ * are written in large chunks whenever the buffer fills up or flush() is called.
+ */
+
+#include "mtUnitOutput.h"
+
+/**
+ * @brief Creates the writer with a buffer big enough for most outputs
+ * @param reserveBytes
+ */
+MTUnitOutput::MTUnitOutput(int reserveBytes) : m_flushThreshold(reserveBytes), m_failed(false)
+{
+    m_buffer.reserve(reserveBytes);
+}
+
+/**
+ * @brief Writes whatever is still buffered if a stream is open
+ */
+MTUnitOutput::~MTUnitOutput()
+{
+    if(m_file.isOpen())
+        closeStream();
+}
+
+/**
+ * @brief Appends text to the buffer, with the same encoding QTextStream uses by default
+ * @param text
+ * @return The writer itself
+ */
+MTUnitOutput &MTUnitOutput::operator<<(const QString &text)
+{
+    QByteArray bytes = text.toLocal8Bit();
+    appendText(bytes.constData(), bytes.size());
+    flushIfFull();
+    return *this;
+}
+
+/**
+ * @brief Appends the bytes of a literal to the buffer as they are
+ * @param text
+ * @return The writer itself
+ */
+MTUnitOutput &MTUnitOutput::operator<<(const char *text)
+{
+    appendText(text, int(qstrlen(text)));
+    flushIfFull();
+    return *this;
+}
+
+/**
+ * @brief Appends a number to the buffer
+ * @param value
+ * @return The writer itself
+ */
+MTUnitOutput &MTUnitOutput::operator<<(int value)
+{
+    m_buffer.append(QByteArray::number(value));
+    flushIfFull();
+    return *this;
+}
+
+/**
+ * @brief Grows the buffer ahead of rendering, when the final size can be estimated
+ * @param bytes
+ */
+void MTUnitOutput::reserve(int bytes)
+{
+    if(bytes > m_buffer.capacity())
+        m_buffer.reserve(bytes);
+    if(bytes > m_flushThreshold)
+        m_flushThreshold = bytes;
+}
+
+/**
+ * @brief Replaces the file with everything rendered so far, in a single
+ * write. The old file is only replaced if the whole content was written.
+ * @param filePath
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitOutput::saveAs(QString filePath)
+{
+    QSaveFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly))
+        return -1;
+    if(file.write(m_buffer) != m_buffer.size())
+    {
+        file.cancelWriting();
+        return -1;
+    }
+    if(!file.commit())
+        return -1;
+    m_buffer.resize(0); //Keeps the reserved capacity for the next use
+    return 1;
+}
+
+/**
+ * @brief Opens a file that will be written in chunks
+ * @param filePath
+ * @param append Keeps the current content of the file
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitOutput::openStream(QString filePath, bool append)
+{
+    m_buffer.resize(0);
+    m_failed = false;
+    m_file.setFileName(filePath);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Unbuffered; //Our buffer is the only one
+    if(append)
+        mode |= QIODevice::Append;
+    if(!m_file.open(mode))
+        return -1;
+    return 1;
+}
+
+/**
+ * @brief Writes everything buffered to the open stream in a single write
+ * @note A failed or short write is remembered, so every later flush() and
+ * closeStream() of this stream fails too: the data is lost either way.
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitOutput::flush()
+{
+    if(!m_file.isOpen() || m_failed)
+        return -1;
+    if(m_buffer.isEmpty())
+        return 1;
+    qint64 written = m_file.write(m_buffer);
+    if(written != m_buffer.size() || !m_file.flush())
+    {
+        qDebug() << "Error: Could not write to: " << m_file.fileName();
+        m_failed = true;
+    }
+    m_buffer.resize(0);
+    return m_failed ? -1 : 1;
+}
+
+/**
+ * @brief Writes the remaining content and closes the stream
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitOutput::closeStream()
+{
+    int result = flush();
+    m_file.close();
+    return result;
+}
+
+/**
+ * @brief Appends text to the buffer, converting line endings the way a file
+ * opened with QIODevice::Text would. Doing it here keeps the file in binary
+ * mode, where a write is not split at every line.
+ * @param text
+ * @param size
+ */
+void MTUnitOutput::appendText(const char *text, int size)
+{
+#ifdef Q_OS_WIN
+    const char *lineStart = text;
+    const char *end = text + size;
+    for(const char *c = text; c < end; c++)
+    {
+        if(*c == '\n')
+        {
+            m_buffer.append(lineStart, int(c - lineStart));
+            m_buffer.append("\r\n", 2);
+            lineStart = c + 1;
+        }
+    }
+    m_buffer.append(lineStart, int(end - lineStart));
+#else
+    m_buffer.append(text, size);
+#endif
+}
+
+/**
+ * @brief Streams never grow past their reserved size, the buffer is
+ * written out as soon as it is full
+ */
+void MTUnitOutput::flushIfFull()
+{
+    if(m_file.isOpen() && m_buffer.size() >= m_flushThreshold)
+        flush();
+}
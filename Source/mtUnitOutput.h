@@ -0,0 +1,53 @@
+/**
+ * @file mtUnitOutput.h
+ * @author Rodrigo Haller
+ * @date 18/10/2026
+ * @brief Buffered writer shared by all tools.
+ * @details Text is rendered into a pre-sized byte buffer that is reused
+ * between writes, so nothing is flushed line by line. Line endings are
+ * converted while rendering (\r\n on Windows) and files are opened in binary
+ * mode, so every write reaches the OS as one call. Whole files
+ * (MTUnitAllTests.mqh, autoRunTest.ini) are written with a single write
+ * and atomically replace the old file. Streams (logFile.log, checkpoint.txt)
+ * are written in large chunks whenever the buffer fills up or flush() is called.
+ */
+
+#ifndef MTUNITOUTPUT_H
+#define MTUNITOUTPUT_H
+
+#include <QFile>
+#include <QSaveFile>
+#include <QByteArray>
+#include <QString>
+#include <QDebug>
+
+class MTUnitOutput
+{
+public:
+    explicit MTUnitOutput(int reserveBytes = 64 * 1024);
+    ~MTUnitOutput();
+
+    MTUnitOutput &operator<<(const QString &text);
+    MTUnitOutput &operator<<(const char *text);
+    MTUnitOutput &operator<<(int value);
+
+    void reserve(int bytes);
+
+    int saveAs(QString filePath);
+
+    int openStream(QString filePath, bool append);
+    bool isStreamOpen() const { return m_file.isOpen(); }
+    int flush();
+    int closeStream();
+
+private:
+    QByteArray m_buffer;
+    QFile m_file;
+    int m_flushThreshold;
+    bool m_failed;
+
+    void appendText(const char *text, int size);
+    void flushIfFull();
+};
+
+#endif // MTUNITOUTPUT_H
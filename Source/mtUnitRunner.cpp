@@ -0,0 +1,315 @@
+/**
+ * @file mtUnitRunner.cpp
+ * @author Rodrigo Haller
+ * @date 18/10/2026
+ * @brief Runs the whole toolchain (generate, compile, link, test and log) in one go.
+ * @details This class reads the commands used to compile the EA and to run
+ * the tester from Runners/mtUnitRun.ini and runs every step as a pipeline.
+ * Steps that do not depend on each other overlap: autoRunTest.ini is written
+ * while the EA compiles and the log is colorized while the tester runs.
+ * At the end it prints how long each stage took.
+ * @note In order to use this class, the argument received by mtUnitHelper.exe
+ * must be: run (optionally followed by the path of the EA.mq5 file)
+ */
+
+#include "mtUnitRunner.h"
+
+/**
+ * @brief Runs the pipeline
+ * @param rootDir
+ * @param eaPath Path of the EA.mq5 file (empty = use the one in mtUnitRun.ini)
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitRunner::start(QString rootDir, QString eaPath)
+{
+    QMap<QString, QString> config;
+    if(readConfig(rootDir, config) < 0)
+        return -1;
+    if(eaPath.isEmpty())
+        eaPath = config.value("Expert");
+    QString compilerCommand = config.value("Compiler");
+    QString testerCommand = config.value("Tester");
+    if(eaPath.isEmpty() || compilerCommand.isEmpty() || testerCommand.isEmpty())
+    {
+        qDebug() << "Error: Expert, Compiler and Tester must be set in mtUnitRun.ini";
+        return -1;
+    }
+    QString expertName = MTUnitEALinker::expertName(eaPath);
+    if(expertName.isEmpty())
+        return -1;
+
+    m_stages.clear();
+    m_collectFailed = false;
+    m_clock.start();
+
+//Generating MTUnitAllTests.mqh, everything else depends on it
+    int generateStage = beginStage("generate");
+    MTUnitTestsCompiler testsCompiler;
+    if(config.value("CompactRunner") == "true")
+        testsCompiler.setRunnerMode(MTUnitTestsCompiler::CompactRunner);
+    if(config.value("Resume") == "true")
+        testsCompiler.setResumeMode(config.value("SkipCrashedCase") == "true" ?
+                                        MTUnitTestsCompiler::ResumeSkippingCrashedCase : MTUnitTestsCompiler::ResumeAfterLastCase);
+    int generated = testsCompiler.start(rootDir);
+    endStage(generateStage);
+    if(generated < 0)
+    {
+        printLatencies();
+        return -1;
+    }
+
+//Compiling the EA while autoRunTest.ini is written
+    int compileStage = beginStage("compile");
+    QDateTime compileStart = QDateTime::currentDateTime();
+    compileStart = compileStart.addMSecs(-compileStart.time().msec()); //Some file systems only keep seconds
+    QProcess compiler;
+    compiler.setWorkingDirectory(rootDir + "/Runners");
+    compiler.setProcessChannelMode(QProcess::ForwardedChannels);
+    startCommand(compiler, expandCommand(compilerCommand, rootDir, eaPath, expertName));
+
+    int linkStage = beginStage("link");
+    MTUnitEALinker eaLinker;
+    eaLinker.setShutdownTerminal(true); //Otherwise the tester command never exits
+    int linked = eaLinker.start(rootDir, expertName);
+    endStage(linkStage);
+
+    bool compiled = waitProcess(compiler, "compile", -1, exitCode(config, "CompilerExitCode"), 0) &&
+                    expertCompiled(rootDir, eaPath, compileStart);
+    endStage(compileStage);
+    if(linked < 0 || !compiled)
+    {
+        printLatencies();
+        return -1;
+    }
+
+//Running the tester while its log is collected
+    int testStage = beginStage("test");
+    int collectStage = beginStage("collect");
+    MTUnitLogger logger;
+    if(logger.beginStream(rootDir) < 0)
+    {
+        printLatencies();
+        return -1;
+    }
+    QProcess tester;
+    tester.setWorkingDirectory(rootDir + "/Runners");
+    tester.setProcessChannelMode(QProcess::ForwardedChannels);
+    startCommand(tester, expandCommand(testerCommand, rootDir, eaPath, expertName));
+    bool tested = waitProcess(tester, "test", config.value("TesterTimeout").toInt() * 1000,
+                              exitCode(config, "TesterExitCode"), &logger);
+    endStage(testStage);
+    int collected = logger.endStream();
+    endStage(collectStage);
+
+    printLatencies();
+    if(!tested || collected < 0 || m_collectFailed)
+        return -1;
+    return 1;
+}
+
+/**
+ * @brief Reads the Key=Value lines of mtUnitRun.ini. Values are kept as they
+ * are (quotes and backslashes included) and startCommand() passes them on
+ * unchanged, so commands can be written exactly as in a command prompt.
+ * @param rootDir
+ * @param config
+ * @return The result of the procedure. (-1 = failure, 1 = success)
+ */
+int MTUnitRunner::readConfig(QString rootDir, QMap<QString, QString> &config)
+{
+    QFile configFile(rootDir + "/Runners/mtUnitRun.ini");
+    if(!configFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qDebug() << "mtUnitRun.ini not found";
+        return -1;
+    }
+    QTextStream in(&configFile);
+    while(!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        if(line.startsWith(";") || line.startsWith("[") || !line.contains("="))
+            continue; //Comments and sections
+        int separatorPos = line.indexOf("=");
+        config[line.left(separatorPos).trimmed()] = line.mid(separatorPos + 1).trimmed();
+    }
+    configFile.close();
+    return 1;
+}
+
+/**
+ * @brief Checks that the compiler really produced the EA: the .ex5 next to
+ * the .mq5 must have been written after the compile stage started.
+ * Otherwise the tester would run the old .ex5.
+ * @param rootDir
+ * @param eaPath
+ * @param compileStart
+ * @return true if a fresh .ex5 exists
+ */
+bool MTUnitRunner::expertCompiled(QString rootDir, QString eaPath, QDateTime compileStart)
+{
+    QString ex5Path = QDir(rootDir + "/Runners").absoluteFilePath(eaPath.replace(".mq", ".ex")); //Relative paths start from Runners
+    QFileInfo ex5File(ex5Path);
+    if(!ex5File.exists() || ex5File.lastModified() < compileStart)
+    {
+        qDebug() << "Error: The EA was not compiled, " << ex5Path << " is missing or out of date";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces the placeholders of a command from mtUnitRun.ini
+ * @details %ROOT% = root dir, %EA% = EA.mq5 path, %EX% = Expert name (.ex5),
+ * %INI% = autoRunTest.ini path
+ * @param command
+ * @param rootDir
+ * @param eaPath
+ * @param expertName
+ * @return The command ready to be started
+ */
+QString MTUnitRunner::expandCommand(QString command, QString rootDir, QString eaPath, QString expertName)
+{
+    command.replace("%ROOT%", QDir::toNativeSeparators(rootDir));
+    command.replace("%EA%", eaPath);
+    command.replace("%EX%", expertName);
+    command.replace("%INI%", QDir::toNativeSeparators(rootDir + "/Runners/autoRunTest.ini"));
+    return command;
+}
+
+/**
+ * @brief Reads an expected exit code from mtUnitRun.ini
+ * @param config
+ * @param key
+ * @return The exit code, or an invalid QVariant if it is not set
+ */
+QVariant MTUnitRunner::exitCode(const QMap<QString, QString> &config, QString key)
+{
+    bool ok = false;
+    int code = config.value(key).toInt(&ok);
+    return ok ? QVariant(code) : QVariant();
+}
+
+/**
+ * @brief Starts a command line from mtUnitRun.ini without touching its
+ * arguments. QProcess::start(QString) would split and requote them, turning
+ * /compile:"C:\Program Files\..." into "/compile:C:\Program Files\...",
+ * which MetaEditor and the terminal do not understand.
+ * @param process
+ * @param command
+ */
+void MTUnitRunner::startCommand(QProcess &process, QString command)
+{
+    command = command.trimmed();
+#ifdef Q_OS_WIN
+    int programEnd;
+    QString program;
+    if(command.startsWith('"')) //Quoted program path
+    {
+        programEnd = command.indexOf('"', 1);
+        if(programEnd < 0)
+            programEnd = command.size();
+        program = command.mid(1, programEnd - 1);
+        programEnd++;
+    }
+    else
+    {
+        programEnd = command.indexOf(' ');
+        if(programEnd < 0)
+            programEnd = command.size();
+        program = command.left(programEnd);
+    }
+    process.setProgram(program);
+    process.setNativeArguments(command.mid(programEnd).trimmed()); //Goes to the command line as it is
+    process.start();
+#else
+    process.start("/bin/sh", QStringList() << "-c" << command); //The shell reads it as it is
+#endif
+}
+
+/**
+ * @brief Starts measuring a stage
+ * @param name
+ * @return The index of the stage, to be passed to endStage()
+ */
+int MTUnitRunner::beginStage(QString name)
+{
+    Stage stage;
+    stage.name = name;
+    stage.startMs = m_clock.elapsed();
+    stage.durationMs = -1;
+    m_stages.append(stage);
+    return m_stages.size() - 1;
+}
+
+/**
+ * @brief Stops measuring a stage
+ * @param stage
+ */
+void MTUnitRunner::endStage(int stage)
+{
+    m_stages[stage].durationMs = m_clock.elapsed() - m_stages[stage].startMs;
+}
+
+/**
+ * @brief Waits for an external command to finish. Meanwhile, whatever the
+ * tester wrote to its log is passed to the logger.
+ * @param process
+ * @param name
+ * @param timeoutMs Kills the process after this time (<= 0 = no timeout)
+ * @param expectedExitCode If valid, any other exit code is a failure
+ * @param logger Can be null. If collecting fails, m_collectFailed is set
+ * @return true if the command finished successfully
+ */
+bool MTUnitRunner::waitProcess(QProcess &process, QString name, int timeoutMs, QVariant expectedExitCode, MTUnitLogger *logger)
+{
+    if(!process.waitForStarted())
+    {
+        qDebug() << "Error: Could not start the " << name << " command: " << process.program();
+        return false;
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    while(!process.waitForFinished(100))
+    {
+        if(process.state() == QProcess::NotRunning)
+            break;
+        if(logger && logger->readAvailable() < 0)
+        {
+            qDebug() << "Error: Could not collect the log, stopped collecting it";
+            logger = 0;
+            m_collectFailed = true;
+        }
+        if(timeoutMs > 0 && elapsed.elapsed() > timeoutMs)
+        {
+            qDebug() << "Error: The " << name << " command timed out";
+            process.kill();
+            process.waitForFinished();
+            return false;
+        }
+    }
+    if(process.exitStatus() != QProcess::NormalExit)
+    {
+        qDebug() << "Error: The " << name << " command crashed";
+        return false;
+    }
+    if(expectedExitCode.isValid() && process.exitCode() != expectedExitCode.toInt())
+    {
+        qDebug() << "Error: The " << name << " command returned " << process.exitCode();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Output when each stage started and how long it took
+ */
+void MTUnitRunner::printLatencies()
+{
+    qDebug().noquote() << QString("%1 %2 %3").arg("Stage", -10).arg("Start (ms)", 12).arg("Duration (ms)", 15);
+    foreach(Stage stage, m_stages)
+    {
+        QString duration = stage.durationMs < 0 ? QString("-") : QString::number(stage.durationMs);
+        qDebug().noquote() << QString("%1 %2 %3").arg(stage.name, -10).arg(stage.startMs, 12).arg(duration, 15);
+    }
+    qDebug().noquote() << QString("%1 %2").arg("Total", -10).arg(m_clock.elapsed(), 12);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file mtUnitRunner.h
+ * @author Rodrigo Haller
+ * @date 18/10/2026
+ * @brief Runs the whole toolchain (generate, compile, link, test and log) in one go.
+ * @details This class reads the commands used to compile the EA and to run
+ * the tester from Runners/mtUnitRun.ini and runs every step as a pipeline.
+ * Steps that do not depend on each other overlap: autoRunTest.ini is written
+ * while the EA compiles and the log is colorized while the tester runs.
+ * At the end it prints how long each stage took.
+ * @note In order to use this class, the argument received by mtUnitHelper.exe
+ * must be: run (optionally followed by the path of the EA.mq5 file)
+ */
+
+#ifndef MTUNITRUNNER_H
+#define MTUNITRUNNER_H
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QList>
+#include <QMap>
+#include <QProcess>
+#include <QStringList>
+#include <QTextStream>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "mtUnitEALinker.h"
+#include "mtUnitLogger.h"
+#include "mtUnitTestsCompiler.h"
+
+class MTUnitRunner
+{
+public:
+    MTUnitRunner() : m_collectFailed(false) {}
+    ~MTUnitRunner(){}
+
+    int start(QString rootDir, QString eaPath);
+
+private:
+    struct Stage
+    {
+        QString name;
+        qint64 startMs;
+        qint64 durationMs;
+    };
+
+    QElapsedTimer m_clock;
+    QList<Stage> m_stages;
+    bool m_collectFailed;
+
+    int readConfig(QString rootDir, QMap<QString, QString> &config);
+    QVariant exitCode(const QMap<QString, QString> &config, QString key);
+    void startCommand(QProcess &process, QString command);
+    bool expertCompiled(QString rootDir, QString eaPath, QDateTime compileStart);
+    QString expandCommand(QString command, QString rootDir, QString eaPath, QString expertName);
+    int beginStage(QString name);
+    void endStage(int stage);
+    bool waitProcess(QProcess &process, QString name, int timeoutMs, QVariant expectedExitCode, MTUnitLogger *logger);
+    void printLatencies();
+};
+
+#endif // MTUNITRUNNER_H
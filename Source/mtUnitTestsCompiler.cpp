@@ -13,6 +13,12 @@
  * @note This class can also be executed in Watcher mode, to enter this mode,
  * do not pass any argument to myUnitHelper.exe
  * @warning In this case, the app will keep running until you close it.
+ * @note Passing "compact" after mtUnitTestsCompiler generates a table driven
+ * runner instead of the fully unrolled runAllTests() method.
+ * @note Passing "resume" (or "resumeSkip", to also skip what crashed)
+ * generates a runner that starts after the last Test Case recorded in
+ * Runners/checkpoint.txt. Otherwise the checkpoint is cleared, once the new
+ * MTUnitAllTests.mqh is written (the Watcher clears it too).
  */
 
 #include "mtUnitTestsCompiler.h"
@@ -72,43 +78,71 @@ void MTUnitTestsCompiler::handleFileChanged(QString file)
  */
 int MTUnitTestsCompiler::start(QString rootDir)
 {
+    qDebug() << "Creating MTUnitAllTests.mqh file...";
 
-    QFile mtUnitAllTestsFile(rootDir + "/Include/MTUnitAllTests.mqh");
-    if(mtUnitAllTestsFile.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        qDebug() << "Creating MTUnitAllTests.mqh file...";
-        QTextStream outMTUnitFile(&mtUnitAllTestsFile);
+//Methods extraction...
+    QDir testsDir(rootDir + "/Test");
+    QStringList testsFound = findTestFiles(testsDir.path());
+    QStringList testFiles;
+    foreach(QString testFileName, testsFound)
+        testFiles.append(testsDir.path() + "/" + testFileName);
+    QMap<QString, QStringList> mapClassXTestCases = testsExtractor(testFiles);
+    printMapClassXTestCases(mapClassXTestCases);
+
+//Resuming from the checkpoint, or starting a fresh one
+    QStringList skippedTestCases;
+    bool freshRun = true;
+    if(m_resumeMode != NoResume)
+        applyCheckpoint(rootDir, mapClassXTestCases, skippedTestCases, freshRun);
+
+//Everything is rendered in memory (sized by the number of Test Cases) and written at once
+    int totalCases = 0;
+    foreach(QStringList testCases, mapClassXTestCases)
+        totalCases += testCases.size();
+    MTUnitOutput outMTUnitFile;
+    outMTUnitFile.reserve(4 * 1024 + totalCases * 256);
 
 //Writing the Header
-        writeHeader(outMTUnitFile);
+    writeHeader(outMTUnitFile);
 
 //Logic to #include the test files...
-        QDir testsDir(rootDir + "/Test");
-        QStringList testsFound = findTestFiles(testsDir.path());
-        writeIncludes(outMTUnitFile, testsFound);
+    writeIncludes(outMTUnitFile, testsFound);
 
-//Creating the MTUnitAllTests class...
-        writeMTUnitClass(outMTUnitFile);
+//The compact runner needs nothing but tests, otherwise we fall back to the unrolled one
+    bool compact = m_runnerMode == CompactRunner && !mapClassXTestCases.isEmpty();
+    if(compact)
+        writeCaseTables(outMTUnitFile, mapClassXTestCases);
 
-//Methods extraction...
-        QStringList testFiles;
-        foreach(QString testFileName, testsFound)
-            testFiles.append(testsDir.path() + "/" + testFileName);
-        QMap<QString, QStringList> mapClassXTestCases = testsExtractor(testFiles);
-        printMapClassXTestCases(mapClassXTestCases);
+//Creating the MTUnitAllTests class...
+    writeMTUnitClass(outMTUnitFile);
 
 //Write RunAllTests method
+    if(compact)
+        writeCompactRunner(outMTUnitFile, mapClassXTestCases);
+    else
         writeRunAllTests(outMTUnitFile, mapClassXTestCases);
 
 //Finishing up...
-        writeEnd(outMTUnitFile);
-        mtUnitAllTestsFile.close();
-    }
-    else
+    writeEnd(outMTUnitFile);
+    if(outMTUnitFile.saveAs(rootDir + "/Include/MTUnitAllTests.mqh") < 0)
     {
         qDebug() << "Error creating MTUnitAllTests.mqh file.";
         return -1;
     }
+
+//Only now the new runner exists, so the checkpoint can change
+    if(freshRun)
+        QFile::remove(rootDir + "/Runners/checkpoint.txt");
+    else if(!skippedTestCases.isEmpty())
+    {
+        MTUnitOutput outCheckpoint(1024);
+        if(outCheckpoint.openStream(rootDir + "/Runners/checkpoint.txt", true) > 0)
+        {
+            foreach(QString testCase, skippedTestCases)
+                outCheckpoint << testCase << " - skipped\n";
+            outCheckpoint.closeStream();
+        }
+    }
     qDebug() << "MTUnitAllTests.mqh generated successfully!";
     return 1;
 }
@@ -277,6 +311,124 @@ QString MTUnitTestsCompiler::testCaseChecker(QString line, bool &found)
     return testCaseName;
 }
 
+/**
+ * @brief Removes from the map every Test Case up to the last one recorded
+ * in the checkpoint (the order is the one the runner uses). When resuming
+ * with ResumeSkippingCrashedCase, the checkpoint also tells what crashed:
+ * - a Test Case that started and never ended: that Test Case is skipped;
+ * - a run ("run" marker) where no Test Case started or ended: something
+ * outside the Test Cases crashed (constructor, initTestSuite...), so the
+ * whole Test Suite where the run stopped is skipped.
+ * @note If every Test Case already ran (or only the crashed one was left),
+ * the run is complete and a fresh one is generated.
+ * @param rootDir
+ * @param mapClassXTestCases
+ * @param skippedTestCases Set to the skipped Test Cases ("TestSuite::TestCase"),
+ * to be recorded once the new runner is generated
+ * @param freshRun Set to true when the checkpoint must be cleared instead
+ * @return The number of Test Cases that won't run again
+ */
+int MTUnitTestsCompiler::applyCheckpoint(QString rootDir, QMap<QString, QStringList> &mapClassXTestCases,
+                                         QStringList &skippedTestCases, bool &freshRun)
+{
+    skippedTestCases.clear();
+    freshRun = true;
+    QFile checkpointFile(rootDir + "/Runners/checkpoint.txt");
+    if(!checkpointFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        qDebug() << "No checkpoint found, running all tests";
+        return 0;
+    }
+    QSet<QString> doneTestCases;
+    bool startedAfterLastEnd = false; //A Test Case started and never ended
+    bool runWithoutProgress = false;  //The last run did not start or end any Test Case
+    QTextStream inCheckpoint(&checkpointFile);
+    while(!inCheckpoint.atEnd())
+    {
+        QString line = inCheckpoint.readLine().trimmed();
+        if(line == "run")
+        {
+            startedAfterLastEnd = false;
+            runWithoutProgress = true;
+        }
+        else if(line == "started")
+        {
+            startedAfterLastEnd = true;
+            runWithoutProgress = false;
+        }
+        else if(!line.isEmpty())
+        {
+            doneTestCases.insert(line.section(" - ", 0, 0).trimmed()); //Ended or skipped
+            startedAfterLastEnd = false;
+            runWithoutProgress = false;
+        }
+    }
+    checkpointFile.close();
+
+    int lastDone = -1;
+    int totalCases = 0;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+    {
+        foreach(QString testCase, it.value())
+        {
+            if(doneTestCases.contains(it.key() + "::" + testCase))
+                lastDone = totalCases;
+            totalCases++;
+        }
+    }
+
+    int resumeAt = lastDone + 1;
+    int skipFrom = -1;
+    int skipTo = -1;
+    if(m_resumeMode == ResumeSkippingCrashedCase && resumeAt < totalCases)
+    {
+        if(startedAfterLastEnd)
+            skipFrom = skipTo = resumeAt;
+        else if(runWithoutProgress)
+        {
+            skipFrom = resumeAt; //Up to the end of its Test Suite
+            int caseIndex = 0;
+            for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+            {
+                caseIndex += it.value().size();
+                if(caseIndex > skipFrom)
+                {
+                    skipTo = caseIndex - 1;
+                    break;
+                }
+            }
+        }
+        if(skipFrom >= 0)
+            resumeAt = skipTo + 1;
+    }
+    if(resumeAt >= totalCases)
+    {
+        qDebug() << "Every Test Case in the checkpoint already ran, starting a fresh run";
+        return 0;
+    }
+
+    QMap<QString, QStringList> remaining;
+    int caseIndex = 0;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+    {
+        foreach(QString testCase, it.value())
+        {
+            if(caseIndex >= skipFrom && caseIndex <= skipTo)
+            {
+                skippedTestCases.append(it.key() + "::" + testCase);
+                qDebug() << "Skipping crashed Test Case: " << skippedTestCases.last();
+            }
+            else if(caseIndex >= resumeAt)
+                remaining[it.key()].append(testCase);
+            caseIndex++;
+        }
+    }
+    mapClassXTestCases = remaining;
+    freshRun = false;
+    qDebug() << "Resuming after " << resumeAt << " of " << totalCases << " Test Cases";
+    return resumeAt;
+}
+
 /**
  * @brief Output the list of Test Suites and Test Cases found
  * @param map
@@ -297,7 +449,7 @@ void MTUnitTestsCompiler::printMapClassXTestCases(QMap<QString, QStringList> map
  * @param outMTUnitFile
  * @param mapClassXTestCases
  */
-void MTUnitTestsCompiler::writeRunAllTests(QTextStream &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases)
+void MTUnitTestsCompiler::writeRunAllTests(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases)
 {
     outMTUnitFile << "    void runAllTests()\n    {\n";
     if(!mapClassXTestCases.isEmpty())
@@ -322,11 +474,138 @@ void MTUnitTestsCompiler::writeRunAllTests(QTextStream &outMTUnitFile, QMap<QStr
     outMTUnitFile << "    }\n";
 }
 
+/**
+ * @brief Write the global tables used by the compact runner: the name of
+ * every Test Case (indexed by its global case index) and the index of the
+ * first Test Case of each Test Suite
+ * @param outMTUnitFile
+ * @param mapClassXTestCases
+ */
+void MTUnitTestsCompiler::writeCaseTables(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases)
+{
+    int totalCases = 0;
+    QStringList suiteFirstCase;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+    {
+        suiteFirstCase.append(QString::number(totalCases));
+        totalCases += it.value().size();
+    }
+    suiteFirstCase.append(QString::number(totalCases)); //Sentinel, so the last suite also knows where it ends
+
+    outMTUnitFile << "\n#define MTUNIT_TOTAL_SUITES " << mapClassXTestCases.size() << "\n";
+    outMTUnitFile << "#define MTUNIT_TOTAL_CASES  " << totalCases << "\n\n";
+    outMTUnitFile << "const int g_mtUnitSuiteFirstCase[] = {" << suiteFirstCase.join(", ") << "};\n\n";
+    outMTUnitFile << "const string g_mtUnitCaseNames[] =\n{\n";
+    int caseIndex = 0;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+    {
+        outMTUnitFile << "    //" << it.key() << "\n";
+        foreach(QString testCase, it.value())
+        {
+            outMTUnitFile << "    \"" << testCase << "\"";
+            if(++caseIndex < totalCases)
+                outMTUnitFile << ",";
+            outMTUnitFile << "\n";
+        }
+    }
+    outMTUnitFile << "};\n";
+}
+
+/**
+ * @brief Write the compact runner of the MTUnitAllTests file. Instead of
+ * one line per Test Case, every Test Suite gets a small method that
+ * dispatches a case index to its Test Case through a switch. These are
+ * named runSuite_<TestSuite>, so they never clash with the other methods.
+ * The cases to run are chosen at runtime, so a range or a list of indexes
+ * can be run without generating the file again.
+ * @param outMTUnitFile
+ * @param mapClassXTestCases
+ */
+void MTUnitTestsCompiler::writeCompactRunner(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases)
+{
+    outMTUnitFile << \
+"    void runAllTests()\n\
+    {\n\
+        runCaseRange(0, MTUNIT_TOTAL_CASES - 1);\n\
+    }\n\
+\n\
+    //Runs every Test Case from firstCase to lastCase (global indexes, both included)\n\
+    void runCaseRange(int firstCase, int lastCase)\n\
+    {\n\
+        int caseIndexes[];\n\
+        firstCase = MathMax(firstCase, 0);\n\
+        lastCase = MathMin(lastCase, MTUNIT_TOTAL_CASES - 1);\n\
+        if(lastCase >= firstCase)\n\
+            ArrayResize(caseIndexes, lastCase - firstCase + 1);\n\
+        for(int i = firstCase; i <= lastCase; i++)\n\
+            caseIndexes[i - firstCase] = i;\n\
+        runCases(caseIndexes);\n\
+    }\n\
+\n\
+    //Runs the listed Test Cases (global indexes, in ascending order)\n\
+    void runCases(const int &caseIndexes[])\n\
+    {\n\
+        int count = ArraySize(caseIndexes);\n\
+        g_mtUnit.initTests();\n\
+        int from = 0;\n\
+        while(from < count)\n\
+        {\n\
+            int suiteIndex = suiteOf(caseIndexes[from]);\n\
+            int to = from;\n\
+            while(to + 1 < count && suiteOf(caseIndexes[to + 1]) == suiteIndex)\n\
+                to++;\n\
+            if(suiteIndex >= 0)\n\
+                runSuite(suiteIndex, caseIndexes, from, to);\n\
+            from = to + 1;\n\
+        }\n\
+        g_mtUnit.endTests();\n\
+    }\n\
+\n\
+    //Returns the Test Suite a case index belongs to (-1 if it is out of range)\n\
+    int suiteOf(int caseIndex)\n\
+    {\n\
+        if(caseIndex < 0 || caseIndex >= MTUNIT_TOTAL_CASES)\n\
+            return -1;\n\
+        int suiteIndex = MTUNIT_TOTAL_SUITES - 1;\n\
+        while(caseIndex < g_mtUnitSuiteFirstCase[suiteIndex])\n\
+            suiteIndex--;\n\
+        return suiteIndex;\n\
+    }\n\
+\n\
+private:\n\
+    void runSuite(int suiteIndex, const int &caseIndexes[], int from, int to)\n\
+    {\n\
+        switch(suiteIndex)\n\
+        {\n";
+    int suiteIndex = 0;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+        outMTUnitFile << "            case " << suiteIndex++ << ": runSuite_" << it.key() << "(caseIndexes, from, to); break;\n";
+    outMTUnitFile << "        }\n    }\n";
+
+    int caseIndex = 0;
+    for(QMap<QString, QStringList>::iterator it = mapClassXTestCases.begin(); it != mapClassXTestCases.end(); it++)
+    {
+        outMTUnitFile << "\n    //Auto generated dispatch for " << it.key() << " Class:\n";
+        outMTUnitFile << "    void runSuite_" << it.key() << "(const int &caseIndexes[], int from, int to)\n    {\n";
+        outMTUnitFile << "        " << it.key() << "* suite = new " << it.key() << "();\n";
+        outMTUnitFile << "        g_mtUnit.initTestSuite(\"" << it.key() << "\");\n";
+        outMTUnitFile << "        for(int i = from; i <= to; i++)\n        {\n";
+        outMTUnitFile << "            g_mtUnit.initTestCase(g_mtUnitCaseNames[caseIndexes[i]]); suite.setUp();\n";
+        outMTUnitFile << "            switch(caseIndexes[i])\n            {\n";
+        foreach(QString testCase, it.value())
+            outMTUnitFile << "                case " << caseIndex++ << ": suite." << testCase << "(); break;\n";
+        outMTUnitFile << "            }\n";
+        outMTUnitFile << "            suite.tearDown(); g_mtUnit.endTestCase();\n        }\n";
+        outMTUnitFile << "        g_mtUnit.endTestSuite();\n";
+        outMTUnitFile << "        delete suite;\n    }\n";
+    }
+}
+
 /**
  * @brief Write the header of the MTUnitAllTests file
  * @param outMTUnitFile
  */
-void MTUnitTestsCompiler::writeHeader(QTextStream &outMTUnitFile)
+void MTUnitTestsCompiler::writeHeader(MTUnitOutput &outMTUnitFile)
 {
     outMTUnitFile << \
 "/**\n\
@@ -352,7 +631,7 @@ void MTUnitTestsCompiler::writeHeader(QTextStream &outMTUnitFile)
 * @brief Write the class snippet
 * @param outMTUnitFile
 */
-void MTUnitTestsCompiler::writeMTUnitClass(QTextStream &outMTUnitFile)
+void MTUnitTestsCompiler::writeMTUnitClass(MTUnitOutput &outMTUnitFile)
 {
    outMTUnitFile << \
 "\nclass MTUnitAllTests\n\
@@ -367,7 +646,7 @@ public:\n\
 * @param outMTUnitFile
 * @param testsFound
 */
-void MTUnitTestsCompiler::writeIncludes(QTextStream &outMTUnitFile, QStringList testsFound)
+void MTUnitTestsCompiler::writeIncludes(MTUnitOutput &outMTUnitFile, QStringList testsFound)
 {
     foreach(QString testName, testsFound)
         outMTUnitFile << "#include \"../Test/" << testName << "\"\n";
@@ -377,7 +656,7 @@ void MTUnitTestsCompiler::writeIncludes(QTextStream &outMTUnitFile, QStringList
 * @brief Write the end of the MTUnitAllTests file
 * @param outMTUnitFile
 */
-void MTUnitTestsCompiler::writeEnd(QTextStream &outMTUnitFile)
+void MTUnitTestsCompiler::writeEnd(MTUnitOutput &outMTUnitFile)
 {
     outMTUnitFile << "};\n";
     outMTUnitFile << "//This file is auto generated!";
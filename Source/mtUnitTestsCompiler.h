@@ -13,6 +13,12 @@
  * @note This class can also be executed in Watcher mode, to enter this mode,
  * do not pass any argument to myUnitHelper.exe
  * @warning In this case, the app will keep running until you close it.
+ * @note Passing "compact" after mtUnitTestsCompiler generates a table driven
+ * runner instead of the fully unrolled runAllTests() method.
+ * @note Passing "resume" (or "resumeSkip", to also skip what crashed)
+ * generates a runner that starts after the last Test Case recorded in
+ * Runners/checkpoint.txt. Otherwise the checkpoint is cleared, once the new
+ * MTUnitAllTests.mqh is written (the Watcher clears it too).
  */
 
 #ifndef MTUNITTESTSCOMPILER_H
@@ -20,6 +26,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QSet>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
@@ -29,14 +36,37 @@
 #include <QFileSystemWatcher>
 #include <QDebug>
 
+#include "mtUnitOutput.h"
+
 class MTUnitTestsCompiler : public QObject
 {
     Q_OBJECT
 public:
-    MTUnitTestsCompiler(){}
+    /**
+     * @brief How the runAllTests() method is generated
+     */
+    enum RunnerMode
+    {
+        UnrolledRunner, ///< One line of calls per Test Case (default)
+        CompactRunner   ///< Case name tables plus a switch based dispatch per Test Suite
+    };
+
+    /**
+     * @brief Where the generated runner starts
+     */
+    enum ResumeMode
+    {
+        NoResume,                 ///< Runs every Test Case and clears the checkpoint (default)
+        ResumeAfterLastCase,      ///< Starts after the last Test Case in the checkpoint
+        ResumeSkippingCrashedCase ///< Same, but also skips the Test Case (or Test Suite) that crashed
+    };
+
+    MTUnitTestsCompiler() : m_runnerMode(UnrolledRunner), m_resumeMode(NoResume) {}
     ~MTUnitTestsCompiler(){}
     void initWatcher(QString rootDir);
     int start(QString rootDir);
+    void setRunnerMode(RunnerMode mode) { m_runnerMode = mode; }
+    void setResumeMode(ResumeMode mode) { m_resumeMode = mode; }
 
 public slots:
     void handleDirectoryChanged(QString dir);
@@ -44,19 +74,25 @@ public slots:
 
 private:
     QFileSystemWatcher *m_watcher;
+    RunnerMode m_runnerMode;
+    ResumeMode m_resumeMode;
 
     QStringList findTestFiles(QString testFolderPath);
     QMap<QString, QStringList> testsExtractor(QStringList testFiles);
     QString clearComments(QString line, bool &commentMode);
     QString classChecker(QString line);
     QString testCaseChecker(QString line, bool &found);
+    int applyCheckpoint(QString rootDir, QMap<QString, QStringList> &mapClassXTestCases,
+                        QStringList &skippedTestCases, bool &freshRun);
 
     void printMapClassXTestCases(QMap<QString, QStringList> map);
-    void writeHeader(QTextStream &outMTUnitFile);
-    void writeMTUnitClass(QTextStream &outMTUnitFile);
-    void writeEnd(QTextStream &outMTUnitFile);
-    void writeIncludes(QTextStream &outMTUnitFile, QStringList testsFound);
-    void writeRunAllTests(QTextStream &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases);
+    void writeHeader(MTUnitOutput &outMTUnitFile);
+    void writeMTUnitClass(MTUnitOutput &outMTUnitFile);
+    void writeEnd(MTUnitOutput &outMTUnitFile);
+    void writeIncludes(MTUnitOutput &outMTUnitFile, QStringList testsFound);
+    void writeRunAllTests(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases);
+    void writeCaseTables(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases);
+    void writeCompactRunner(MTUnitOutput &outMTUnitFile, QMap<QString, QStringList> mapClassXTestCases);
 };
 
 #endif // MTUNITTESTSCOMPILER_H
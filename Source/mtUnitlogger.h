@@ -11,6 +11,9 @@
  * @warning The colored output does not work directly from MetaEditor, so if
  * you want to use it, I suggest you to follow the instructions for using this
  * tool in Sublime Text 3.
+ * @note Every run, and every Test Case that starts or ends, is also recorded
+ * in Runners/checkpoint.txt, so mtUnitTestsCompiler can resume the run if the
+ * tester dies halfway.
  */
 
 #ifndef MTUNITLOGGER_H
@@ -21,15 +24,39 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <QTextCodec>
+#include <QRegExp>
 #include <QDebug>
 
+#include "mtUnitOutput.h"
+
 class MTUnitLogger
 {
 public:
-    MTUnitLogger(){}
-    ~MTUnitLogger(){}
+    MTUnitLogger() : m_outLog(256 * 1024), m_outCheckpoint(4 * 1024), m_decoder(0), m_runRecorded(false), m_testCaseRunning(false) {}
+    ~MTUnitLogger(){ delete m_decoder; }
 
     int start(QString rootDir);
+
+    int beginStream(QString rootDir);
+    int readAvailable();
+    int endStream();
+
+private:
+    QFile m_logFile;
+    MTUnitOutput m_outLog;
+    MTUnitOutput m_outCheckpoint;
+    QTextDecoder *m_decoder;
+    QString m_logFilePath;
+    QString m_pendingLine;
+    bool m_runRecorded;
+    bool m_testCaseRunning;
+
+    void writeLine(QString line);
+    QString checkpointChecker(QString line, bool &found);
+    bool testCaseStartChecker(QString line);
 };
 
 #endif // MTUNITLOGGER_H